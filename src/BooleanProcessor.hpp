@@ -1,16 +1,19 @@
 #ifndef BOOLEANPROCESSOR_HPP
 #define BOOLEANPROCESSOR_HPP
 
+#include "TruthTable.hpp"
+#include "KMap.hpp"
 #include <vector>
 #include <string>
 
 class BooleanProcessor {
 public:
-    static std::vector<std::vector<int>> booleanToTruthTable(const std::string& booleanExpression);
-    static std::vector<std::vector<int>> truthTableToKMap(const std::vector<std::vector<int>>& truthTable);
-    static void printTruthTable(const std::vector<std::vector<int>>& truthTable);
-    static void printKMap(const std::vector<std::vector<int>>& kmap);
-    static std::vector<std::vector<int>> generateTruthTable(int numVars);
+    static TruthTable booleanToTruthTable(const std::string& booleanExpression);
+    static KMap truthTableToKMap(const TruthTable& truthTable);
+    static KMap truthTableToKMap(TruthTable&&) = delete;
+    static void printTruthTable(const TruthTable& truthTable);
+    static void printKMap(const KMap& kmap);
+    static TruthTable generateTruthTable(int numVars);
 private:
     static int evaluateBooleanExpression(const std::string& booleanExpression, const std::vector<int>& variables);
 };
@@ -0,0 +1,7 @@
+#include "KMap.hpp"
+
+// Constructor
+KMap::KMap(const TruthTable& table) : table(&table) {
+    rowBits = table.numVars() / 2;
+    colBits = table.numVars() - rowBits;
+}
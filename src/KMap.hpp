@@ -0,0 +1,32 @@
+#ifndef KMAP_HPP
+#define KMAP_HPP
+
+#include "TruthTable.hpp"
+
+// Zero-copy Gray-code view of a truth table as a 2^floor(n/2) x 2^ceil(n/2) K-map.
+// Rows index the leading variables, columns the trailing ones; the table must outlive the view.
+class KMap {
+public:
+    explicit KMap(const TruthTable& table);
+    KMap(TruthTable&&) = delete;
+
+    int numVars() const { return table->numVars(); }
+    int rows() const { return 1 << rowBits; }
+    int cols() const { return 1 << colBits; }
+
+    // Truth table row shown at cell (r, c)
+    std::size_t minterm(int r, int c) const {
+        return (static_cast<std::size_t>(r ^ (r >> 1)) << colBits) | static_cast<std::size_t>(c ^ (c >> 1));
+    }
+
+    bool at(int r, int c) const { return table->output(minterm(r, c)); }
+
+    const TruthTable& truthTable() const { return *table; }
+
+private:
+    const TruthTable* table;
+    int rowBits;
+    int colBits;
+};
+
+#endif // KMAP_HPP
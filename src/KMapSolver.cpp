@@ -1,336 +1,466 @@
 #include "KMapSolver.hpp"
 #include <iostream>
 #include <stdexcept>
-#include <set>
+#include <bitset>
+#include <algorithm>
+#include <queue>
+#include <tuple>
 
 // Constructor
-KMapSolver::KMapSolver(const std::vector<std::vector<int>>& kmap) : kmap(kmap) {
-    numVars = numVariables();
+KMapSolver::KMapSolver(const KMap& kmap) : kmap(kmap) {
+    numVars = kmap.numVars();
     variables = getVariableNames(numVars);
 }
 
-// Determine the number of variables based on the K-map size
-int KMapSolver::numVariables() {
-    int rows = kmap.size();
-    int cols = kmap[0].size();
-    if (rows == 2 && cols == 2) {
-        return 2;
-    } else if (rows == 2 && cols == 4) {
-        return 3;
-    } else if (rows == 4 && cols == 4) {
-        return 4;
-    } else {
-        throw std::invalid_argument("Invalid K-map size");
-    }
-}
-
 // Get variable names based on the number of variables
 std::vector<std::string> KMapSolver::getVariableNames(int num_vars) {
-    if (num_vars == 2) {
-        return {"A", "B"};
-    } else if (num_vars == 3) {
-        return {"A", "B", "C"};
-    } else if (num_vars == 4) {
-        return {"A", "B", "C", "D"};
-    } else {
+    if (num_vars < 1 || num_vars > 26) {
         throw std::invalid_argument("Invalid number of variables");
     }
+    std::vector<std::string> names;
+    for (int i = 0; i < num_vars; ++i) {
+        names.push_back(std::string(1, static_cast<char>('A' + i)));
+    }
+    return names;
 }
 
-// Generate term from rows and columns
-std::string KMapSolver::getTerm(const std::set<int>& rows, const std::set<int>& cols, bool isSOP) {
-    std::vector<std::string> terms;
-
-    // Handle the rows (A, B)
-    if (numVars >= 3) {
-        if (rows.size() == 2) {
-            auto it = rows.begin();
-            int first = *it;
-            int second = *(++it);
-            if ((first == 0 && second == 1) || (first == 2 && second == 3)) {
-                // Change in B only
-                terms.push_back(variables[1] + (isSOP ? "" : "'"));
-            } else if ((first == 0 && second == 3) || (first == 1 && second == 2)) {
-                // Change in A only
-                terms.push_back(variables[0] + (isSOP ? "" : "'"));
-            }
-        } else if (rows.size() == 1) {
-            int row = *rows.begin();
-            if ((row & 2) == 0) {
-                terms.push_back(variables[0] + (isSOP ? "'" : ""));
-            } else {
-                terms.push_back(variables[0] + (isSOP ? "" : "'"));
+// Collect the minterms to cover: 1-cells for SOP, 0-cells for POS.
+// Scans the packed truth table word by word, so minterms come out in ascending order.
+std::vector<int> KMapSolver::targetMinterms(bool isSOP) {
+    const TruthTable& table = kmap.truthTable();
+    const auto& words = table.words();
+
+    std::vector<int> minterms;
+    minterms.reserve(table.size() / 2);
+    for (size_t w = 0; w < words.size(); ++w) {
+        std::uint64_t bits = isSOP ? words[w] : ~words[w];
+        for (int b = 0; bits != 0; ++b, bits >>= 1) {
+            size_t row = w * 64 + b;
+            if (row >= table.size()) {
+                break;
             }
-            if ((row & 1) == 0) {
-                terms.push_back(variables[1] + (isSOP ? "'" : ""));
-            } else {
-                terms.push_back(variables[1] + (isSOP ? "" : "'"));
+            if (bits & 1) {
+                minterms.push_back(row);
             }
         }
     }
+    return minterms;
+}
 
-    // Handle the columns (C, D)
-    if (numVars == 4) {
-        if (cols.size() == 2) {
-            auto it = cols.begin();
-            int first = *it;
-            int second = *(++it);
-            if ((first == 0 && second == 1) || (first == 2 && second == 3)) {
-                // Change in D only
-                terms.push_back(variables[3] + (isSOP ? "" : "'"));
-            } else if ((first == 0 && second == 3) || (first == 1 && second == 2)) {
-                // Change in C only
-                terms.push_back(variables[2] + (isSOP ? "" : "'"));
-            }
-        } else if (cols.size() == 1) {
-            int col = *cols.begin();
-            if ((col & 2) == 0) {
-                terms.push_back(variables[2] + (isSOP ? "'" : ""));
-            } else {
-                terms.push_back(variables[2] + (isSOP ? "" : "'"));
+// Charge one unit of work and check cancellation and the time/work budgets
+bool KMapSolver::shouldStop() {
+    if (stopped) {
+        return true;
+    }
+    ++work;
+    if (options->cancel && options->cancel->load(std::memory_order_relaxed)) {
+        stopped = cancelled = true;
+    } else if (options->workBudget != 0 && work > workLimit) {
+        stopped = true;
+    } else if (options->timeBudget.count() != 0 && std::chrono::steady_clock::now() >= deadline) {
+        stopped = true;
+    }
+    return stopped;
+}
+
+// Notify the caller of the current best cover
+void KMapSolver::reportProgress(bool isSOP, const std::vector<Implicant>& cover, bool optimal) {
+    if (!options->onProgress) {
+        return;
+    }
+    std::size_t literals = 0;
+    for (const auto& implicant : cover) {
+        literals += countLiterals(implicant);
+    }
+    options->onProgress({isSOP, work, cover.size(), literals, optimal});
+}
+
+// Quine-McCluskey merging. Levels are sorted, so each cube only looks up its neighbours across
+// one variable instead of being compared with the whole level. Returns false if stopped early.
+bool KMapSolver::primeImplicants(const std::vector<int>& minterms, std::vector<Implicant>& implicants) {
+    std::vector<std::pair<int, int>> level;
+    for (int m : minterms) {
+        level.push_back({m, 0});
+    }
+
+    while (!level.empty()) {
+        std::vector<std::pair<int, int>> next;
+        std::vector<bool> merged(level.size(), false);
+
+        for (size_t i = 0; i < level.size(); ++i) {
+            if (shouldStop()) {
+                return false;
             }
-            if ((col & 1) == 0) {
-                terms.push_back(variables[3] + (isSOP ? "'" : ""));
-            } else {
-                terms.push_back(variables[3] + (isSOP ? "" : "'"));
+            int value = level[i].first;
+            int mask = level[i].second;
+            for (int bit = 1; bit < (1 << numVars); bit <<= 1) {
+                if ((mask & bit) || (value & bit)) {
+                    continue;
+                }
+                std::pair<int, int> neighbour = {value | bit, mask};
+                auto it = std::lower_bound(level.begin(), level.end(), neighbour);
+                if (it != level.end() && *it == neighbour) {
+                    next.push_back({value, mask | bit});
+                    merged[i] = merged[it - level.begin()] = true;
+                }
             }
         }
-    }
 
-    std::string term;
-    if (isSOP) {
-        for (const auto& t : terms) {
-            term += t;
+        for (size_t i = 0; i < level.size(); ++i) {
+            if (!merged[i]) {
+                implicants.push_back({level[i].first, level[i].second});
+            }
         }
-    } else {
-        for (size_t i = 0; i < terms.size(); ++i) {
-            if (i > 0) term += "+";
-            term += terms[i];
+        if (shouldStop()) {
+            return false;
         }
+        std::sort(next.begin(), next.end());
+        next.erase(std::unique(next.begin(), next.end()), next.end());
+        level.swap(next);
     }
+    return true;
+}
 
-    return term;
+// Indices of the minterms an implicant covers, walking every assignment of its eliminated variables
+void KMapSolver::coveredMinterms(const std::vector<int>& minterms, const Implicant& implicant, std::vector<int>& indices) {
+    indices.clear();
+    int sub = 0;
+    do {
+        auto it = std::lower_bound(minterms.begin(), minterms.end(), implicant.value | sub);
+        if (it != minterms.end() && *it == (implicant.value | sub)) {
+            indices.push_back(it - minterms.begin());
+        }
+        sub = (sub - implicant.mask) & implicant.mask;
+    } while (sub != 0);
 }
 
-// Check if a cell is in a group
-bool KMapSolver::isInGroup(const std::vector<std::pair<int, int>>& group, int r, int c) {
-    for (const auto& cell : group) {
-        if (cell.first == r && cell.second == c) {
-            return true;
+// Fallback once the budget is gone: expand each uncovered minterm into a prime by dropping literals
+// while the cube stays inside the target set. Costs one pass over the map, not a search.
+void KMapSolver::expandCover(const std::vector<int>& minterms, bool isSOP,
+                             std::vector<bool>& covered, std::vector<Implicant>& cover) {
+    const TruthTable& table = kmap.truthTable();
+    auto inTarget = [&](int value, int mask) {
+        int sub = 0;
+        do {
+            if (table.output(value | sub) != isSOP) {
+                return false;
+            }
+            sub = (sub - mask) & mask;
+        } while (sub != 0);
+        return true;
+    };
+
+    // Track coverage by truth table row so marking a cube needs no searches
+    std::vector<bool> coveredRows(table.size(), false);
+    for (size_t i = 0; i < minterms.size(); ++i) {
+        if (covered[i]) {
+            coveredRows[minterms[i]] = true;
         }
     }
-    return false;
+
+    for (size_t i = 0; i < minterms.size(); ++i) {
+        if (coveredRows[minterms[i]]) {
+            continue;
+        }
+        Implicant cube = {minterms[i], 0};
+        for (int bit = 1; bit < (1 << numVars); bit <<= 1) {
+            if (inTarget(cube.value ^ bit, cube.mask)) {
+                cube.value &= ~bit;
+                cube.mask |= bit;
+            }
+        }
+        int sub = 0;
+        do {
+            coveredRows[cube.value | sub] = true;
+            sub = (sub - cube.mask) & cube.mask;
+        } while (sub != 0);
+        cover.push_back(cube);
+    }
+    covered.assign(minterms.size(), true);
 }
 
-// Check if a cell is inside a 2x2 group
-bool KMapSolver::isInside2x2Group(int r, int c) {
-    for (const auto& grouping : twoByTwoGroupings) {
-        if (isInGroup(grouping.cells, r, c)) {
-            return true;
+// For each implicant, the indices of the minterms it covers, and the reverse mapping
+void KMapSolver::coverLists(const std::vector<int>& minterms, const std::vector<Implicant>& implicants,
+                            std::vector<std::vector<int>>& covers, std::vector<std::vector<int>>& coveredBy) {
+    covers.assign(implicants.size(), {});
+    coveredBy.assign(minterms.size(), {});
+    for (size_t p = 0; p < implicants.size(); ++p) {
+        coveredMinterms(minterms, implicants[p], covers[p]);
+        for (int i : covers[p]) {
+            coveredBy[i].push_back(p);
         }
     }
-    return false;
 }
 
-// Find groupings
-void KMapSolver::findGroupings(bool isSOP) {
-    int rows = kmap.size();
-    int cols = kmap[0].size();
-    std::vector<std::vector<bool>> visited(rows, std::vector<bool>(cols, false));
+// Greedy set cover: repeatedly take the implicant covering the most uncovered minterms.
+// Gains are updated incrementally; if stopped, the rest is finished by expandCover.
+std::vector<Implicant> KMapSolver::greedyCover(const std::vector<int>& minterms, const std::vector<Implicant>& implicants, bool isSOP) {
+    std::vector<std::vector<int>> covers;
+    std::vector<std::vector<int>> coveredBy;
+    coverLists(minterms, implicants, covers, coveredBy);
 
-    auto getWrappedIndex = [&](int index, int maxIndex) {
-        return (index + maxIndex) % maxIndex;
-    };
+    // Entries are (gain, -literals, index); stale gains are refreshed when popped
+    std::vector<size_t> gain(implicants.size());
+    std::priority_queue<std::tuple<size_t, int, int>> queue;
+    for (size_t p = 0; p < implicants.size(); ++p) {
+        gain[p] = covers[p].size();
+        queue.push({gain[p], -countLiterals(implicants[p]), p});
+    }
+
+    std::vector<bool> covered(minterms.size(), false);
+    size_t remaining = minterms.size();
+    std::vector<Implicant> cover;
 
-    // Check for corner wrap-around groupings
-    if ((isSOP && kmap[0][0] == 1 && kmap[0][cols - 1] == 1 && kmap[rows - 1][0] == 1 && kmap[rows - 1][cols - 1] == 1) ||
-        (!isSOP && kmap[0][0] == 0 && kmap[0][cols - 1] == 0 && kmap[rows - 1][0] == 0 && kmap[rows - 1][cols - 1] == 0)) {
-        Grouping grouping;
-        std::set<int> groupRows = {0, rows - 1};
-        std::set<int> groupCols = {0, cols - 1};
-        grouping.cells.push_back({0, 0});
-        grouping.cells.push_back({0, cols - 1});
-        grouping.cells.push_back({rows - 1, 0});
-        grouping.cells.push_back({rows - 1, cols - 1});
-        grouping.term = getTerm(groupRows, groupCols, isSOP);
-        if (isSOP) {
-            sopGroupings.push_back(grouping);
-        } else {
-            posGroupings.push_back(grouping);
+    while (remaining > 0 && !shouldStop()) {
+        auto [queuedGain, negLiterals, p] = queue.top();
+        queue.pop();
+        if (queuedGain != gain[p]) {
+            if (gain[p] > 0) {
+                queue.push({gain[p], negLiterals, p});
+            }
+            continue;
         }
-        twoByTwoGroupings.push_back(grouping);
-        visited[0][0] = visited[0][cols - 1] = visited[rows - 1][0] = visited[rows - 1][cols - 1] = true;
-    }
 
-    // Find 2x2 groupings
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (!visited[r][c] && ((isSOP && kmap[r][c] == 1) || (!isSOP && kmap[r][c] == 0))) {
-                int rNext = getWrappedIndex(r + 1, rows);
-                int cNext = getWrappedIndex(c + 1, cols);
-                if (kmap[r][c] == kmap[rNext][c] && kmap[r][c] == kmap[r][cNext] && kmap[r][c] == kmap[rNext][cNext]) {
-                    Grouping grouping;
-                    std::set<int> groupRows = {r, rNext};
-                    std::set<int> groupCols = {c, cNext};
-                    grouping.cells.push_back({r, c});
-                    grouping.cells.push_back({rNext, c});
-                    grouping.cells.push_back({r, cNext});
-                    grouping.cells.push_back({rNext, cNext});
-                    grouping.term = getTerm(groupRows, groupCols, isSOP);
-                    if (isSOP) {
-                        sopGroupings.push_back(grouping);
-                    } else {
-                        posGroupings.push_back(grouping);
-                    }
-                    twoByTwoGroupings.push_back(grouping);
-                    visited[r][c] = visited[rNext][c] = visited[r][cNext] = visited[rNext][cNext] = true;
+        for (int i : covers[p]) {
+            if (!covered[i]) {
+                covered[i] = true;
+                --remaining;
+                for (int q : coveredBy[i]) {
+                    --gain[q];
                 }
             }
         }
+        cover.push_back(implicants[p]);
     }
 
-    // Find 1x2 and 2x1 groupings that can group with already grouped cells
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (!visited[r][c] && ((isSOP && kmap[r][c] == 1) || (!isSOP && kmap[r][c] == 0))) {
-                int rNext = getWrappedIndex(r + 1, rows);
-                int cNext = getWrappedIndex(c + 1, cols);
-
-                if (kmap[r][c] == kmap[rNext][c]) {
-                    Grouping grouping;
-                    std::set<int> groupRows = {r, rNext};
-                    std::set<int> groupCols = {c};
-                    grouping.cells.push_back({r, c});
-                    grouping.cells.push_back({rNext, c});
-                    grouping.term = getTerm(groupRows, groupCols, isSOP);
-                    if (isSOP) {
-                        sopGroupings.push_back(grouping);
-                    } else {
-                        posGroupings.push_back(grouping);
-                    }
-                    visited[r][c] = visited[rNext][c] = true;
-                } else if (kmap[r][c] == kmap[r][cNext]) {
-                    Grouping grouping;
-                    std::set<int> groupRows = {r};
-                    std::set<int> groupCols = {c, cNext};
-                    grouping.cells.push_back({r, c});
-                    grouping.cells.push_back({r, cNext});
-                    grouping.term = getTerm(groupRows, groupCols, isSOP);
-                    if (isSOP) {
-                        sopGroupings.push_back(grouping);
-                    } else {
-                        posGroupings.push_back(grouping);
-                    }
-                    visited[r][c] = visited[r][cNext] = true;
-                }
+    if (remaining > 0) {
+        expandCover(minterms, isSOP, covered, cover);
+    }
+    return cover;
+}
 
-                // Try to group with cells already in a group
-                if (rNext < rows && !visited[rNext][c] && isInGroup(sopGroupings.back().cells, rNext, c)) {
-                    sopGroupings.back().cells.push_back({r, c});
-                    sopGroupings.back().term = getTerm({r, rNext}, {c}, isSOP);
-                    visited[r][c] = true;
-                } else if (r - 1 >= 0 && !visited[r - 1][c] && isInGroup(sopGroupings.back().cells, r - 1, c)) {
-                    sopGroupings.back().cells.push_back({r, c});
-                    sopGroupings.back().term = getTerm({r - 1, r}, {c}, isSOP);
-                    visited[r][c] = true;
-                } else if (cNext < cols && !visited[r][cNext] && isInGroup(sopGroupings.back().cells, r, cNext)) {
-                    sopGroupings.back().cells.push_back({r, c});
-                    sopGroupings.back().term = getTerm({r}, {c, cNext}, isSOP);
-                    visited[r][c] = true;
-                } else if (c - 1 >= 0 && !visited[r][c - 1] && isInGroup(sopGroupings.back().cells, r, c - 1)) {
-                    sopGroupings.back().cells.push_back({r, c});
-                    sopGroupings.back().term = getTerm({r}, {c - 1, c}, isSOP);
-                    visited[r][c] = true;
-                }
+// Branch-and-bound over prime covers, minimizing term count then literal count.
+// Improves best in place; returns true if the search finished, proving best optimal.
+bool KMapSolver::exactCover(const std::vector<int>& minterms, const std::vector<Implicant>& primes, std::vector<Implicant>& best, bool isSOP) {
+    int count = minterms.size();
+    std::vector<std::vector<int>> covers;
+    std::vector<std::vector<int>> coveredBy;
+    coverLists(minterms, primes, covers, coveredBy);
+    size_t maxCover = 1;
+    for (const auto& covered : covers) {
+        maxCover = std::max(maxCover, covered.size());
+    }
+
+    // Try larger primes first so good covers are found early
+    for (auto& candidates : coveredBy) {
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+            if (covers[a].size() != covers[b].size()) {
+                return covers[a].size() > covers[b].size();
             }
-        }
+            return countLiterals(primes[a]) < countLiterals(primes[b]);
+        });
     }
 
-    // Find single cell groupings without adding adjacent cells
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (!visited[r][c] && !isInside2x2Group(r, c) && ((isSOP && kmap[r][c] == 1) || (!isSOP && kmap[r][c] == 0))) {
-                Grouping grouping;
-                std::set<int> groupRows = {r};
-                std::set<int> groupCols = {c};
-                grouping.cells.push_back({r, c});
-                grouping.term = getTerm(groupRows, groupCols, isSOP);
-                if (isSOP) {
-                    sopGroupings.push_back(grouping);
-                } else {
-                    posGroupings.push_back(grouping);
+    std::pair<size_t, size_t> bestCost = {best.size(), 0};
+    for (const auto& implicant : best) {
+        bestCost.second += countLiterals(implicant);
+    }
+
+    std::vector<int> coverCount(count, 0);
+    std::vector<int> chosen;
+    size_t literals = 0;
+
+    std::function<void(int)> search = [&](int uncovered) {
+        if (shouldStop()) {
+            return;
+        }
+        if (uncovered == 0) {
+            if (std::make_pair(chosen.size(), literals) < bestCost) {
+                bestCost = {chosen.size(), literals};
+                best.clear();
+                for (int p : chosen) {
+                    best.push_back(primes[p]);
                 }
-                visited[r][c] = true;
+                reportProgress(isSOP, best, false);
             }
+            return;
+        }
+
+        size_t needed = chosen.size() + (uncovered + maxCover - 1) / maxCover;
+        if (std::make_pair(needed, literals) >= bestCost) {
+            return;
         }
-    }
 
-    // Check for vertical wrap-around groupings with cross-referencing against 2x2 groupings
-    for (int c = 0; c < cols; ++c) {
-        if (((isSOP && kmap[0][c] == 1 && kmap[rows - 1][c] == 1) ||
-             (!isSOP && kmap[0][c] == 0 && kmap[rows - 1][c] == 0)) &&
-            !isInside2x2Group(0, c) && !isInside2x2Group(rows - 1, c)) {
-            Grouping grouping;
-            std::set<int> groupRows = {0, rows - 1};
-            std::set<int> groupCols = {c};
-            grouping.cells.push_back({0, c});
-            grouping.cells.push_back({rows - 1, c});
-            grouping.term = getTerm(groupRows, groupCols, isSOP);
-            if (isSOP) {
-                sopGroupings.push_back(grouping);
-            } else {
-                posGroupings.push_back(grouping);
+        // Branch on the uncovered minterm with the fewest candidate primes
+        int pick = -1;
+        for (int i = 0; i < count; ++i) {
+            if (coverCount[i] == 0 && (pick < 0 || coveredBy[i].size() < coveredBy[pick].size())) {
+                pick = i;
             }
-            visited[0][c] = visited[rows - 1][c] = true;
         }
-    }
 
-    // Check for horizontal wrap-around groupings with cross-referencing against 2x2 groupings
-    for (int r = 0; r < rows; ++r) {
-        if (((isSOP && kmap[r][0] == 1 && kmap[r][cols - 1] == 1) ||
-             (!isSOP && kmap[r][0] == 0 && kmap[r][cols - 1] == 0)) &&
-            !isInside2x2Group(r, 0) && !isInside2x2Group(r, cols - 1)) {
-            Grouping grouping;
-            std::set<int> groupRows = {r};
-            std::set<int> groupCols = {0, cols - 1};
-            grouping.cells.push_back({r, 0});
-            grouping.cells.push_back({r, cols - 1});
-            grouping.term = getTerm(groupRows, groupCols, isSOP);
-            if (isSOP) {
-                sopGroupings.push_back(grouping);
-            } else {
-                posGroupings.push_back(grouping);
+        for (int p : coveredBy[pick]) {
+            int newlyCovered = 0;
+            for (int i : covers[p]) {
+                if (coverCount[i]++ == 0) {
+                    ++newlyCovered;
+                }
+            }
+            chosen.push_back(p);
+            literals += countLiterals(primes[p]);
+
+            search(uncovered - newlyCovered);
+
+            literals -= countLiterals(primes[p]);
+            chosen.pop_back();
+            for (int i : covers[p]) {
+                --coverCount[i];
+            }
+            if (stopped) {
+                return;
             }
-            visited[r][0] = visited[r][cols - 1] = true;
         }
+    };
+
+    search(count);
+    return !stopped;
+}
+
+// Minimize one polarity; returns true if the resulting cover is proven optimal
+bool KMapSolver::minimize(bool isSOP, std::string& expression) {
+    std::vector<int> minterms = targetMinterms(isSOP);
+    std::vector<Implicant> best;
+    if (minterms.empty()) {
+        reportProgress(isSOP, best, true);
+        expression = generateExpression(best, isSOP);
+        return true;
+    }
+
+    // Out of budget, whether before or while merging: fall back to a single expand pass
+    std::vector<Implicant> implicants;
+    if (!shouldStop() && primeImplicants(minterms, implicants)) {
+        best = greedyCover(minterms, implicants, isSOP);
+    } else {
+        std::vector<bool> covered(minterms.size(), false);
+        expandCover(minterms, isSOP, covered, best);
+    }
+    reportProgress(isSOP, best, false);
+
+    bool optimal = !stopped && exactCover(minterms, implicants, best, isSOP);
+    if (optimal) {
+        reportProgress(isSOP, best, true);
     }
+
+    expression = generateExpression(best, isSOP);
+    return optimal;
 }
 
-// Generate expression with unique terms
-std::string KMapSolver::generateExpression(const std::list<Grouping>& groupings, bool isSOP) {
-    std::set<std::string> uniqueTerms;
-    std::string expression;
+// Number of literals an implicant contributes to the expression
+int KMapSolver::countLiterals(const Implicant& implicant) {
+    return numVars - static_cast<int>(std::bitset<32>(implicant.mask).count());
+}
 
-    for (const auto& grouping : groupings) {
-        if (uniqueTerms.find(grouping.term) == uniqueTerms.end()) {
-            if (!expression.empty()) {
-                expression += isSOP ? " + " : " ";
-            }
-            expression += isSOP ? grouping.term : "(" + grouping.term + ")";
-            uniqueTerms.insert(grouping.term);
+// Order implicants by literal count, then by descending value; buckets avoid recounting bits in comparisons
+void KMapSolver::sortByLiterals(std::vector<Implicant>& implicants) {
+    std::vector<std::vector<Implicant>> buckets(numVars + 1);
+    for (const auto& implicant : implicants) {
+        buckets[countLiterals(implicant)].push_back(implicant);
+    }
+    implicants.clear();
+    for (auto& bucket : buckets) {
+        std::sort(bucket.begin(), bucket.end(), [](const Implicant& a, const Implicant& b) {
+            return a.value > b.value;
+        });
+        implicants.insert(implicants.end(), bucket.begin(), bucket.end());
+    }
+}
+
+// Append the term for an implicant to out; variable names are single letters
+void KMapSolver::appendTerm(const Implicant& implicant, bool isSOP, std::string& out) {
+    char buffer[3 * 26];
+    int length = 0;
+    for (int i = 0; i < numVars; ++i) {
+        int bit = numVars - i - 1;
+        if ((implicant.mask >> bit) & 1) {
+            continue;
+        }
+        if (!isSOP && length > 0) {
+            buffer[length++] = '+';
+        }
+        buffer[length++] = variables[i][0];
+        // SOP complements cleared variables, POS complements set ones
+        if (((implicant.value >> bit) & 1) != isSOP) {
+            buffer[length++] = '\'';
+        }
+    }
+    out.append(buffer, length);
+}
+
+// Generate expression from a cover, simplest terms first
+std::string KMapSolver::generateExpression(std::vector<Implicant> cover, bool isSOP) {
+    if (cover.empty()) {
+        return isSOP ? "0" : "1";
+    }
+
+    sortByLiterals(cover);
+
+    // A term with no literals spans the whole map: the function is constant
+    if (countLiterals(cover.front()) == 0) {
+        return isSOP ? "1" : "0";
+    }
+
+    std::string expression;
+    expression.reserve(cover.size() * (3 * numVars + 3));
+    for (const auto& implicant : cover) {
+        if (!expression.empty()) {
+            expression += isSOP ? " + " : " ";
+        }
+        if (!isSOP) {
+            expression += '(';
+        }
+        appendTerm(implicant, isSOP, expression);
+        if (!isSOP) {
+            expression += ')';
         }
     }
 
     return expression;
 }
 
-// Generate SOP and POS expressions
+// Generate SOP and POS expressions without limits
 std::pair<std::string, std::string> KMapSolver::kmapToSOPandPOS() {
-    findGroupings(true);  // Find SOP groupings
-    findGroupings(false); // Find POS groupings
+    SolveResult result = kmapToSOPandPOS(SolveOptions{});
+    return {result.sop, result.pos};
+}
+
+// Generate SOP and POS expressions within the given budget, keeping the best cover found so far
+SolveResult KMapSolver::kmapToSOPandPOS(const SolveOptions& solveOptions) {
+    if (solveOptions.timeBudget.count() == 0 && solveOptions.workBudget == 0 && !solveOptions.cancel &&
+        numVars > maxUnboundedVars) {
+        throw std::invalid_argument("Too many variables for an unbounded solve; pass SolveOptions with a budget");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto timeBudget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(solveOptions.timeBudget);
+    options = &solveOptions;
+    work = 0;
+    stopped = false;
+    cancelled = false;
+
+    // SOP may use half of each budget so POS is never left without a search
+    SolveResult result;
+    deadline = start + timeBudget / 2;
+    workLimit = (solveOptions.workBudget + 1) / 2;
+    result.sopOptimal = minimize(true, result.sop);
 
-    std::string sop_result = generateExpression(sopGroupings, true);
-    std::string pos_result = generateExpression(posGroupings, false);
+    // POS gets the remainder, including whatever SOP left unused
+    stopped = cancelled;
+    deadline = start + timeBudget;
+    workLimit = solveOptions.workBudget;
+    result.posOptimal = minimize(false, result.pos);
+    result.cancelled = cancelled;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
 
-    return {sop_result, pos_result};
+    options = nullptr;
+    return result;
 }
@@ -1,37 +1,92 @@
 #ifndef KMAPSOLVER_HPP
 #define KMAPSOLVER_HPP
 
+#include "KMap.hpp"
 #include <vector>
 #include <string>
-#include <list>
-#include <set>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
 
-struct Grouping {
-    std::vector<std::pair<int, int>> cells;
-    std::string term;
+// A product (SOP) or sum (POS) term: minterm bits in value, eliminated variables in mask
+struct Implicant {
+    int value;
+    int mask;
+};
+
+// Snapshot passed to the progress callback whenever the best cover improves
+struct SolveProgress {
+    bool isSOP;
+    std::size_t work;
+    std::size_t terms;
+    std::size_t literals;
+    bool optimal;
+};
+
+// Limits for a minimization run; zero budgets mean unlimited.
+// SOP may use at most half of each budget; POS gets the rest, including whatever SOP left unused.
+// An unlimited run is exponential, so it is refused above KMapSolver::maxUnboundedVars unless
+// a budget or a cancel flag is given.
+struct SolveOptions {
+    std::chrono::milliseconds timeBudget{0};
+    std::size_t workBudget = 0;
+    std::function<void(const SolveProgress&)> onProgress;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Best SOP/POS covers found; heuristic when the budget ran out before the search finished
+struct SolveResult {
+    std::string sop;
+    std::string pos;
+    bool sopOptimal = false;
+    bool posOptimal = false;
+    bool cancelled = false;
+    // Wall time spent; may exceed the time budget by the cost of building the fallback cover and strings
+    std::chrono::milliseconds elapsed{0};
+
+    bool optimal() const { return sopOptimal && posOptimal; }
 };
 
 class KMapSolver {
 public:
-    KMapSolver(const std::vector<std::vector<int>>& kmap);
+    KMapSolver(const KMap& kmap);
+
+    // Largest map solved without any budget or cancel flag; larger maps need one
+    static constexpr int maxUnboundedVars = 6;
 
     std::pair<std::string, std::string> kmapToSOPandPOS();
+    SolveResult kmapToSOPandPOS(const SolveOptions& options);
 
 private:
-    std::vector<std::vector<int>> kmap;
+    KMap kmap;
     int numVars;
     std::vector<std::string> variables;
-    std::list<Grouping> sopGroupings;
-    std::list<Grouping> posGroupings;
-    std::vector<Grouping> twoByTwoGroupings;
 
-    int numVariables();
+    const SolveOptions* options = nullptr;
+    std::chrono::steady_clock::time_point deadline;
+    std::size_t work = 0;
+    std::size_t workLimit = 0;
+    bool stopped = false;
+    bool cancelled = false;
+
     std::vector<std::string> getVariableNames(int num_vars);
-    std::string getTerm(const std::set<int>& rows, const std::set<int>& cols, bool isSOP);
-    bool isInGroup(const std::vector<std::pair<int, int>>& group, int r, int c);
-    bool isInside2x2Group(int r, int c);
-    void findGroupings(bool isSOP);
-    std::string generateExpression(const std::list<Grouping>& groupings, bool isSOP);
+    std::vector<int> targetMinterms(bool isSOP);
+    bool shouldStop();
+    void reportProgress(bool isSOP, const std::vector<Implicant>& cover, bool optimal);
+    bool primeImplicants(const std::vector<int>& minterms, std::vector<Implicant>& implicants);
+    void coveredMinterms(const std::vector<int>& minterms, const Implicant& implicant, std::vector<int>& indices);
+    void expandCover(const std::vector<int>& minterms, bool isSOP,
+                     std::vector<bool>& covered, std::vector<Implicant>& cover);
+    void coverLists(const std::vector<int>& minterms, const std::vector<Implicant>& implicants,
+                    std::vector<std::vector<int>>& covers, std::vector<std::vector<int>>& coveredBy);
+    std::vector<Implicant> greedyCover(const std::vector<int>& minterms, const std::vector<Implicant>& implicants, bool isSOP);
+    bool exactCover(const std::vector<int>& minterms, const std::vector<Implicant>& primes, std::vector<Implicant>& best, bool isSOP);
+    bool minimize(bool isSOP, std::string& expression);
+    int countLiterals(const Implicant& implicant);
+    void sortByLiterals(std::vector<Implicant>& implicants);
+    void appendTerm(const Implicant& implicant, bool isSOP, std::string& out);
+    std::string generateExpression(std::vector<Implicant> cover, bool isSOP);
 };
 
 #endif // KMAPSOLVER_HPP
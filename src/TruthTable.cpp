@@ -0,0 +1,10 @@
+#include "TruthTable.hpp"
+#include <stdexcept>
+
+// Constructor; all outputs start at 0
+TruthTable::TruthTable(int numVars) : vars(numVars) {
+    if (numVars < 0 || numVars > 26) {
+        throw std::invalid_argument("Invalid number of variables");
+    }
+    bits.assign((size() + 63) / 64, 0);
+}
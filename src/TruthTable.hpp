@@ -0,0 +1,41 @@
+#ifndef TRUTHTABLE_HPP
+#define TRUTHTABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Truth table over numVars inputs with one output bit per row, packed 64 rows per word.
+// Inputs are implicit in the row index, with the first variable as the most significant bit.
+class TruthTable {
+public:
+    explicit TruthTable(int numVars = 0);
+
+    int numVars() const { return vars; }
+    std::size_t size() const { return std::size_t(1) << vars; }
+
+    bool input(std::size_t row, int var) const {
+        return (row >> (vars - var - 1)) & 1;
+    }
+
+    bool output(std::size_t row) const {
+        return (bits[row >> 6] >> (row & 63)) & 1;
+    }
+
+    void setOutput(std::size_t row, bool value) {
+        std::uint64_t bit = std::uint64_t(1) << (row & 63);
+        if (value) {
+            bits[row >> 6] |= bit;
+        } else {
+            bits[row >> 6] &= ~bit;
+        }
+    }
+
+    const std::vector<std::uint64_t>& words() const { return bits; }
+
+private:
+    int vars;
+    std::vector<std::uint64_t> bits;
+};
+
+#endif // TRUTHTABLE_HPP
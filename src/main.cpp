@@ -10,13 +10,26 @@ void printMenu() {
     std::cout << "Enter your choice: ";
 }
 
+// Print the K-map and its SOP/POS forms, settling for a heuristic cover if the time budget runs out
+void solveAndPrint(const TruthTable& truthTable) {
+    auto kmap = BooleanProcessor::truthTableToKMap(truthTable);
+    BooleanProcessor::printKMap(kmap);
+
+    SolveOptions options;
+    options.timeBudget = std::chrono::milliseconds(2000);
+    KMapSolver solver(kmap);
+    SolveResult result = solver.kmapToSOPandPOS(options);
+    std::cout << "SOP: " << result.sop << (result.sopOptimal ? " (optimal)" : " (heuristic)") << std::endl;
+    std::cout << "POS: " << result.pos << (result.posOptimal ? " (optimal)" : " (heuristic)") << std::endl;
+}
+
 int main() {
     int choice;
     printMenu();
     std::cin >> choice;
 
     std::string booleanExpression;
-    std::vector<std::vector<int>> truthTable;
+    TruthTable truthTable;
     const int numVars = 4; // Assuming 4 variables for option 3
 
     switch (choice) {
@@ -32,32 +45,20 @@ int main() {
             std::cin.ignore();
             std::getline(std::cin, booleanExpression);
             truthTable = BooleanProcessor::booleanToTruthTable(booleanExpression);
-            {
-                auto kmap = BooleanProcessor::truthTableToKMap(truthTable);
-                BooleanProcessor::printKMap(kmap);
-                KMapSolver solver(kmap);
-                auto [sop_result, pos_result] = solver.kmapToSOPandPOS();
-                std::cout << "SOP: " << sop_result << std::endl;
-                std::cout << "POS: " << pos_result << std::endl;
-            }
+            solveAndPrint(truthTable);
             break;
         case 3:
             truthTable = BooleanProcessor::generateTruthTable(numVars);
             for (int i = 0; i < (1 << numVars); ++i) {
                 for (int j = 0; j < numVars; ++j) {
-                    std::cout << truthTable[i][j] << " ";
+                    std::cout << truthTable.input(i, j) << " ";
                 }
                 std::cout << ": Output for row " << i + 1 << ": ";
-                std::cin >> truthTable[i][numVars];
-            }
-            {
-                auto kmap = BooleanProcessor::truthTableToKMap(truthTable);
-                BooleanProcessor::printKMap(kmap);
-                KMapSolver solver(kmap);
-                auto [sop_result, pos_result] = solver.kmapToSOPandPOS();
-                std::cout << "SOP: " << sop_result << std::endl;
-                std::cout << "POS: " << pos_result << std::endl;
+                int output;
+                std::cin >> output;
+                truthTable.setOutput(i, output);
             }
+            solveAndPrint(truthTable);
             break;
         default:
             std::cout << "Invalid choice!" << std::endl;